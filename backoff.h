@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <random>
 
 // BackoffStrategy Interface
@@ -13,7 +14,8 @@ public:
 class ExponentialBackoffStrategy : public BackoffStrategy {
 public:
     int calculateBackoffTime(std::mt19937& gen, int collisionCount, int successfulCount=0) override {
-        std::uniform_int_distribution<> backoffDist(0, std::min(1024, 1 << collisionCount) - 1);
+        // Cap the shift so long runs with large collision counts cannot overflow.
+        std::uniform_int_distribution<> backoffDist(0, std::min(1024, 1 << std::clamp(collisionCount, 0, 10)) - 1);
         return backoffDist(gen);
     }
 };
@@ -47,7 +49,8 @@ public:
 
     int calculateBackoffTime(std::mt19937& gen, int collisionCount, int successfulCount=0) override {
         // Ensure the collision count does not decrease the CW below 1.
-        int CW = std::min(CWmax, CWmin * (1 << std::max(0, collisionCount)));
+        // Widen before shifting and cap the shift so large collision counts cannot overflow.
+        int CW = static_cast<int>(std::min<long long>(CWmax, static_cast<long long>(CWmin) << std::clamp(collisionCount, 0, 30)));
         // Subtract 1 from CW to account for zero-based index when using CW as range.
         std::uniform_int_distribution<> backoffDist(0, std::max(1, CW) - 1);
         return backoffDist(gen);
@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+
+// 802.11e EDCA (Enhanced Distributed Channel Access)
+//
+// Access Categories : Each node carries up to four traffic classes (background, best effort,
+// video, voice), each with its own queue and contention state. Higher categories win.
+//
+// AIFSN : Number of idle slots an access category waits after the channel becomes idle
+// before its backoff counter starts to decrement. Smaller values give higher priority.
+//
+// CWmin and CWmax : Per-category contention window bounds. After each failed attempt the
+// window grows as CW = min(CWmax, (CWmin + 1) * 2^retry - 1).
+//
+// TXOP Limit : Number of back-to-back frames a category may send once it wins the channel.
+// The simulator models one frame per slot, so the limit is expressed in frames (minimum 1).
+//
+// Internal Collisions : When several categories of the same node finish their backoff in the
+// same slot, the highest category transmits and the others back off as if they had collided.
+
+enum AccessCategory {
+    AC_BK = 0, // Background
+    AC_BE,     // Best effort
+    AC_VI,     // Video
+    AC_VO,     // Voice
+    AC_COUNT
+};
+
+struct EdcaParameters
+{
+    int aifsn;
+    int CWmin;
+    int CWmax;
+    int txopLimit;
+};
+
+struct EdcaClassStats
+{
+    std::int64_t successful;         // Frames delivered
+    std::int64_t collisions;         // Attempts lost to other nodes
+    std::int64_t internalCollisions; // Attempts lost to a higher category on the same node
+    std::int64_t dropped;            // Frames discarded after the retry limit
+};
+
+struct EdcaTransmissions
+{
+    std::array<EdcaClassStats, AC_COUNT> classes;
+    std::int64_t successful;
+    std::int64_t collisions;
+};
+
+// EdcaConfiguration Class
+//
+// Holds the per-category parameters together with contention window lookup tables, indexed
+// by retry count, that are built once up front. Drawing a backoff is a table lookup plus one
+// random number regardless of how many categories are enabled.
+class EdcaConfiguration {
+public:
+    static constexpr int retryLimit = 7;
+
+private:
+    std::array<EdcaParameters, AC_COUNT> parameters;
+    std::array<bool, AC_COUNT> enabled;
+    std::array<std::array<std::uniform_int_distribution<>::param_type, retryLimit + 1>, AC_COUNT> backoffTable;
+
+    void buildTables() {
+        for (int ac = 0; ac < AC_COUNT; ++ac) {
+            const EdcaParameters& p = parameters[ac];
+            for (int retry = 0; retry <= retryLimit; ++retry) {
+                long long CW = std::min<long long>(p.CWmax, (static_cast<long long>(p.CWmin) + 1) * (1LL << retry) - 1);
+                backoffTable[ac][retry] = std::uniform_int_distribution<>::param_type(0, static_cast<int>(std::max(1LL, CW)));
+            }
+        }
+    }
+
+public:
+    // Defaults follow the 802.11 EDCA parameter set for an OFDM PHY (aCWmin 15, aCWmax 1023).
+    EdcaConfiguration()
+        : parameters{ {
+            { 7, 15, 1023, 1 }, // AC_BK
+            { 3, 15, 1023, 1 }, // AC_BE
+            { 2, 7, 15, 4 },    // AC_VI
+            { 2, 3, 7, 2 },     // AC_VO
+        } },
+          enabled{ true, true, true, true } {
+        buildTables();
+    }
+
+    void setParameters(AccessCategory ac, const EdcaParameters& value) {
+        parameters[ac] = EdcaParameters{ std::max(1, value.aifsn), std::max(1, value.CWmin), std::max(value.CWmin, value.CWmax), std::max(1, value.txopLimit) };
+        buildTables();
+    }
+
+    void setEnabled(AccessCategory ac, bool value) {
+        enabled[ac] = value;
+    }
+
+    const EdcaParameters& getParameters(int ac) const {
+        return parameters[ac];
+    }
+
+    bool isEnabled(int ac) const {
+        return enabled[ac];
+    }
+
+    int drawBackoff(std::mt19937& gen, int ac, int retry) const {
+        std::uniform_int_distribution<> backoffDist;
+        return backoffDist(gen, backoffTable[ac][std::min(retry, retryLimit)]);
+    }
+};
@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Per-window channel statistics for a single simulation run
+struct MetricsWindow
+{
+    std::int64_t startSlot;
+    std::int64_t slotCount;
+    std::int64_t successful;
+    std::int64_t collisions;
+};
+
+// Whole-run view of the windows, kept even when the ring buffer has overwritten early windows
+struct MetricsSummary
+{
+    MetricsWindow first;
+    MetricsWindow last;
+    MetricsWindow peak;          // Window with the most collisions
+    std::int64_t windows;        // Windows completed in the run
+    std::int64_t droppedWindows; // Windows overwritten in the ring buffer
+};
+
+// WindowedMetrics Class
+//
+// Streaming metrics stage fed once per simulated slot. Successes and collisions are
+// accumulated over windows of a fixed number of slots; each completed window is pushed
+// into a bounded ring buffer (oldest windows are overwritten) and, optionally, appended
+// to a CSV file with one row per window of every run. The first and most congested windows
+// are kept outside the ring, so long runs can expose convergence or congestion collapse
+// without storing per-slot data.
+class WindowedMetrics {
+private:
+    std::int64_t windowSlots;
+    std::vector<MetricsWindow> ring;
+    std::size_t capacity;
+    std::size_t head;          // Index of the oldest window in the ring
+    std::size_t count;         // Number of valid windows in the ring
+    std::int64_t droppedWindows;
+    std::int64_t windowCount;
+    std::int64_t run;           // Runs started, written as the first CSV column
+    MetricsWindow current;
+    MetricsWindow first;
+    MetricsWindow last;
+    MetricsWindow peak;
+    std::ofstream csv;
+
+    void flush() {
+        if (current.slotCount == 0) {
+            return;
+        }
+
+        if (windowCount == 0) {
+            first = current;
+        }
+        if (windowCount == 0 || current.collisions > peak.collisions) {
+            peak = current;
+        }
+        last = current;
+        windowCount++;
+
+        if (capacity > 0) {
+            if (count < capacity) {
+                ring[(head + count) % capacity] = current;
+                count++;
+            }
+            else {
+                ring[head] = current;
+                head = (head + 1) % capacity;
+                droppedWindows++;
+            }
+        }
+
+        if (csv.is_open()) {
+            csv << run << ',' << current.startSlot << ',' << current.slotCount << ',' << current.successful << ',' << current.collisions << '\n';
+        }
+
+        current = MetricsWindow{ current.startSlot + current.slotCount, 0, 0, 0 };
+    }
+
+public:
+    WindowedMetrics(std::int64_t windowSlots = 1000, std::size_t capacity = 1024, const std::string& csvPath = "")
+        : windowSlots(std::max<std::int64_t>(1, windowSlots)), ring(capacity), capacity(capacity), head(0), count(0),
+          droppedWindows(0), windowCount(0), run(0), current{ 0, 0, 0, 0 }, first{ 0, 0, 0, 0 }, last{ 0, 0, 0, 0 }, peak{ 0, 0, 0, 0 } {
+        if (!csvPath.empty()) {
+            csv.open(csvPath, std::ios::out | std::ios::trunc);
+            if (csv.is_open()) {
+                csv << "run,startSlot,slotCount,successful,collisions\n";
+            }
+        }
+    }
+
+    // False if no CSV path was given or the file could not be created.
+    bool isStreaming() const {
+        return csv.is_open();
+    }
+
+    // Reset the ring buffer at the start of a run.
+    void begin() {
+        head = 0;
+        count = 0;
+        droppedWindows = 0;
+        windowCount = 0;
+        run++;
+        current = MetricsWindow{ 0, 0, 0, 0 };
+    }
+
+    // Record count consecutive slots that all had the same number of transmitting nodes,
+    // e.g. an idle stretch skipped over in one step.
+    void recordSlots(std::int64_t count, int transmittingNodes) {
+        while (count > 0) {
+            std::int64_t take = std::min(count, windowSlots - current.slotCount);
+            current.slotCount += take;
+            if (transmittingNodes == 1) {
+                current.successful += take;
+            }
+            else if (transmittingNodes > 1) {
+                current.collisions += take;
+            }
+            count -= take;
+
+            if (current.slotCount == windowSlots) {
+                flush();
+            }
+        }
+    }
+
+    // Record the outcome of one slot given the number of transmitting nodes.
+    void recordSlot(int transmittingNodes) {
+        current.slotCount++;
+        if (transmittingNodes == 1) {
+            current.successful++;
+        }
+        else if (transmittingNodes > 1) {
+            current.collisions++;
+        }
+
+        if (current.slotCount == windowSlots) {
+            flush();
+        }
+    }
+
+    // Flush the trailing partial window at the end of a run.
+    void end() {
+        flush();
+        if (csv.is_open()) {
+            csv.flush();
+        }
+    }
+
+    // Windows currently held in the ring buffer, oldest first.
+    std::vector<MetricsWindow> windows() const {
+        std::vector<MetricsWindow> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            result.push_back(ring[(head + i) % capacity]);
+        }
+        return result;
+    }
+
+    // First, last and peak windows of the run, including windows dropped from the ring.
+    MetricsSummary summary() const {
+        return MetricsSummary{ first, last, peak, windowCount, droppedWindows };
+    }
+
+    std::int64_t getWindowSlots() const {
+        return windowSlots;
+    }
+
+    // Number of windows overwritten because the ring buffer was full.
+    std::int64_t getDroppedWindows() const {
+        return droppedWindows;
+    }
+};
@@ -8,16 +8,67 @@ Simulation::Simulation(QObject* parent, int numSimulations)
 void Simulation::doWork(std::shared_ptr<Simulator> simulator)
 {
     std::vector<Point> collisionData;
+    collisionData.reserve(simulator->getNumSimulations());
+
+    // Per-worker scratch reused by every replica
+    SimulationContext context(simulator->getNumberNodes());
     auto averageCollisions = 0.0;
 
     // Variables to track simulation results
-    int totalCollisions = 0;
-    int totalSuccessful = 0;
+    std::int64_t totalCollisions = 0;
+    std::int64_t totalSuccessful = 0;
+
+    // Windowed metrics are reset on every run, so the ring holds the last simulation.
+    std::shared_ptr<WindowedMetrics> metrics = simulator->getMetrics();
+
+    // Per access category totals when running in EDCA mode
+    std::shared_ptr<EdcaConfiguration> edcaConfiguration = simulator->getEdcaConfiguration();
+    EdcaTransmissions edcaTotals{};
+
+    // Trace only the first simulation; the file is opened up front so a failure is reported before the run
+    std::unique_ptr<TraceWriter> trace;
+    bool traced = false;
+    if (!simulator->getTracePath().empty()) {
+        trace = std::make_unique<TraceWriter>(simulator->getTracePath(), simulator->getNumberNodes());
+        if (!trace->isOpen()) {
+            emit traceFailed(QString::fromStdString(simulator->getTracePath()));
+            trace.reset();
+        }
+    }
 
     for (auto simulation = 0; simulation < simulator->getNumSimulations(); ++simulation) {
 
-        Transmissions simulatedTransmissions = simulator->simulateCSMACA(simulator->getNumberNodes(), simulator->getBackoffStrategy(), simulator->getMinPacketSize(),
-            simulator->getMaxPacketSize(), simulator->getSimulationTime(), simulator->getNumSimulations());
+        Transmissions simulatedTransmissions{};
+        if (edcaConfiguration) {
+            EdcaTransmissions edcaTransmissions = simulator->simulateEDCA(context, simulator->getNumberNodes(), *edcaConfiguration, simulator->getSimulationTime(),
+                metrics.get(), trace.get());
+            for (int ac = 0; ac < AC_COUNT; ++ac) {
+                edcaTotals.classes[ac].successful += edcaTransmissions.classes[ac].successful;
+                edcaTotals.classes[ac].collisions += edcaTransmissions.classes[ac].collisions;
+                edcaTotals.classes[ac].internalCollisions += edcaTransmissions.classes[ac].internalCollisions;
+                edcaTotals.classes[ac].dropped += edcaTransmissions.classes[ac].dropped;
+            }
+            edcaTotals.successful += edcaTransmissions.successful;
+            edcaTotals.collisions += edcaTransmissions.collisions;
+
+            simulatedTransmissions.successful = edcaTransmissions.successful;
+            simulatedTransmissions.collisions = edcaTransmissions.collisions;
+        }
+        else {
+            simulatedTransmissions = simulator->simulateCSMACA(context, simulator->getNumberNodes(), simulator->getBackoffStrategy().get(), simulator->getMinPacketSize(),
+                simulator->getMaxPacketSize(), simulator->getSimulationTime(), metrics.get(), trace.get());
+        }
+
+        // The writer is closed before the file is read back
+        if (trace) {
+            if (trace->close(simulator->getSimulationTime())) {
+                traced = true;
+            }
+            else {
+                emit traceFailed(QString::fromStdString(simulator->getTracePath()));
+            }
+            trace.reset();
+        }
 
         totalCollisions += simulatedTransmissions.collisions;
         totalSuccessful += simulatedTransmissions.successful;
@@ -33,5 +84,14 @@ void Simulation::doWork(std::shared_ptr<Simulator> simulator)
     averageCollisions += (double)totalCollisions / simulator->getNumSimulations();
 
     emit collisionDataReady(collisionData); // Emit the transmission data - used in chartView
+    if (metrics) {
+        emit windowDataReady(metrics->summary());
+    }
+    if (edcaConfiguration) {
+        emit edcaDataReady(edcaTotals);
+    }
+    if (traced) {
+        emit traceReady(QString::fromStdString(simulator->getTracePath())); // Replaces the chart with the traced run
+    }
     emit finished(averageCollisions);       // Emit finished - will delete simulation and simulator
 }
\ No newline at end of file
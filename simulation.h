@@ -1,16 +1,19 @@
 #pragma once
 
 #include <QObject>
+#include <QString>
+#include <cstdint>
 #include <vector>
 #include <random>
 #include "simulator.h"
+#include "metrics.h"
 
 struct Point
 {
     int simulation;
-    int collisions;
+    std::int64_t collisions;
 
-    Point(int simulation, int collisions) : simulation(simulation), collisions(collisions) {}
+    Point(int simulation, std::int64_t collisions) : simulation(simulation), collisions(collisions) {}
 };
 
 class Simulation : public QObject {
@@ -23,6 +26,10 @@ signals:
     void progressUpdated(int value);
     void finished(double value);
     void collisionDataReady(std::vector<Point> value);
+    void windowDataReady(MetricsSummary value);
+    void edcaDataReady(EdcaTransmissions value);
+    void traceReady(QString path);
+    void traceFailed(QString path);
 
 public slots:
     void doWork(std::shared_ptr<Simulator> simulator);
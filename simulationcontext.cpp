@@ -0,0 +1,52 @@
+#include "simulationcontext.h"
+
+SimulationContext::Scratch::Scratch(std::size_t storageSize)
+    : storage(std::make_unique<std::byte[]>(storageSize)), arena(storage.get(), storageSize), nodes(&arena), transmittingIndices(&arena),
+      edcaQueues(&arena), edcaWinners(&arena)
+{
+}
+
+SimulationContext::SimulationContext(int maxNodes)
+    : maxNodes(0)
+{
+    std::random_device rd;
+    gen.seed(rd());
+    grow(std::max(1, maxNodes));
+}
+
+void SimulationContext::grow(int numberNodes)
+{
+    // Room for every buffer plus alignment padding inside the arena
+    std::size_t storageSize = numberNodes * (sizeof(Node) + 2 * sizeof(int) + AC_COUNT * sizeof(EdcaQueue)) + 4 * alignof(std::max_align_t);
+
+    scratch.reset(); // Release the old arena before building the new one
+    scratch = std::make_unique<Scratch>(storageSize);
+    scratch->nodes.reserve(numberNodes);
+    scratch->transmittingIndices.reserve(numberNodes);
+    scratch->edcaQueues.reserve(static_cast<std::size_t>(numberNodes) * AC_COUNT);
+    scratch->edcaWinners.reserve(numberNodes);
+    maxNodes = numberNodes;
+}
+
+void SimulationContext::reset(int numberNodes, BackoffStrategy* backoffStrategy)
+{
+    if (numberNodes > maxNodes) {
+        grow(numberNodes);
+    }
+
+    // Both stay within the reserved capacity, so nothing is allocated here
+    scratch->nodes.assign(numberNodes, Node(backoffStrategy));
+    scratch->transmittingIndices.clear();
+}
+
+
+void SimulationContext::resetEdca(int numberNodes)
+{
+    if (numberNodes > maxNodes) {
+        grow(numberNodes);
+    }
+
+    scratch->edcaQueues.assign(static_cast<std::size_t>(numberNodes) * AC_COUNT, EdcaQueue{ 0, 0 });
+    scratch->edcaWinners.clear();
+    scratch->transmittingIndices.clear();
+}
\ No newline at end of file
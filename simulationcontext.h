@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <vector>
+#include "backoff.h"
+#include "edca.h"
+
+// Node structure to simulate each device in the network
+struct Node {
+    int packetSize;
+    int backoffTime;
+    bool isReadyToTransmit;
+    BackoffStrategy* backoffStrategy; // Pointer to backoff strategy, owned by the caller
+
+    // Constructor
+    Node(BackoffStrategy* strategy) : packetSize(0), backoffTime(0), isReadyToTransmit(false), backoffStrategy(strategy) {}
+
+    // Randomize node behavior
+    void randomize(std::mt19937& gen, std::uniform_int_distribution<>& packetSizeDist) {
+        packetSize = packetSizeDist(gen);
+        isReadyToTransmit = true; // Node is ready to transmit at the start
+    }
+
+    // Reset backoff time using the strategy pattern
+    // Run totals are 64-bit; clamp them to the int range the strategies expect.
+    void resetBackoffTime(std::mt19937& gen, std::int64_t collisionCount, std::int64_t successfulCount) {
+        if (backoffStrategy) {
+            backoffTime = backoffStrategy->calculateBackoffTime(gen, static_cast<int>(std::min<std::int64_t>(collisionCount, INT_MAX)),
+                static_cast<int>(std::min<std::int64_t>(successfulCount, INT_MAX)));
+        }
+    }
+
+    // Simulate node behavior for a time unit
+    void simulateTimeUnit() {
+        if (backoffTime > 0) {
+            backoffTime--;
+            isReadyToTransmit = backoffTime == 0;
+        }
+    }
+};
+
+// Contention state of one access category on one node
+struct EdcaQueue {
+    int backoff; // Backoff slots left once AIFS has elapsed
+    int retry;   // Failed attempts for the frame at the head of the queue
+};
+
+// SimulationContext Class
+//
+// Reusable per-worker state for simulateCSMACA and simulateEDCA. Node, queue and scratch
+// buffers live in an arena sized for the largest node count seen so far and are reset, not
+// reallocated, between replicas. checkSteadyStateAllocations in the wifivalidate target counts
+// global heap allocations over warm replicas of both engines and fails if any are made.
+class SimulationContext {
+public:
+    explicit SimulationContext(int maxNodes = 0);
+
+    // Prepare the buffers for a replica, growing the arena only if numberNodes exceeds its capacity.
+    void reset(int numberNodes, BackoffStrategy* backoffStrategy);
+    void resetEdca(int numberNodes);
+
+    void seed(std::uint32_t value)
+    {
+        gen.seed(value);
+    }
+
+    std::mt19937& getGenerator()
+    {
+        return gen;
+    }
+
+    std::pmr::vector<Node>& getNodes()
+    {
+        return scratch->nodes;
+    }
+
+    std::pmr::vector<int>& getTransmittingIndices()
+    {
+        return scratch->transmittingIndices;
+    }
+
+    // One queue per node and access category, indexed node * AC_COUNT + category
+    std::pmr::vector<EdcaQueue>& getEdcaQueues()
+    {
+        return scratch->edcaQueues;
+    }
+
+    std::pmr::vector<int>& getEdcaWinners()
+    {
+        return scratch->edcaWinners;
+    }
+
+private:
+    // Arena-backed buffers, rebuilt as a whole when a larger node count is requested
+    struct Scratch {
+        std::unique_ptr<std::byte[]> storage;
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<Node> nodes;
+        std::pmr::vector<int> transmittingIndices;
+        std::pmr::vector<EdcaQueue> edcaQueues;
+        std::pmr::vector<int> edcaWinners;
+
+        explicit Scratch(std::size_t storageSize);
+    };
+
+    int maxNodes;
+    std::unique_ptr<Scratch> scratch;
+    std::mt19937 gen;
+
+    void grow(int numberNodes);
+};
@@ -1,77 +1,128 @@
 #include "simulator.h"
+#include <algorithm>
+#include <climits>
 
-// Node structure to simulate each device in the network
-struct Node {
-    int packetSize;
-    int backoffTime;
-    bool isReadyToTransmit;
-    std::shared_ptr<BackoffStrategy> backoffStrategy; // Pointer to backoff strategy
 
-    // Constructor
-    Node(std::shared_ptr<BackoffStrategy> strategy) : packetSize(0), backoffTime(0), isReadyToTransmit(false), backoffStrategy(strategy) {}
+Simulator::Simulator(int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, int numSimulations)
+    :numberNodes(numberNodes), minPacketSize(minPacketSize), maxPacketSize(maxPacketSize), simulationTime(simulationTime), numSimulations(numSimulations)
+{
+}
+
+Transmissions Simulator::simulateCSMACA(int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, int simulations, WindowedMetrics* metrics) const
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+
+    return simulateCSMACA(gen, numberNodes, std::move(backoffStrategy), minPacketSize, maxPacketSize, simulationTime, simulations, metrics);
+}
+
+// Reference per-slot engine, seeded by the caller so runs can be reproduced exactly.
+Transmissions Simulator::simulateCSMACA(std::mt19937& gen, int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, int simulations, WindowedMetrics* metrics) const
+{
+    std::normal_distribution<double> distribution(0, 1);
 
-    // Randomize node behavior
-    void randomize(std::mt19937& gen, std::uniform_int_distribution<>& packetSizeDist) {
-        packetSize = packetSizeDist(gen);
-        isReadyToTransmit = true; // Node is ready to transmit at the start
+    std::uniform_int_distribution<> packetSizeDist(minPacketSize, maxPacketSize); 
+
+    std::vector<Node> nodes(numberNodes, Node(backoffStrategy.get())); // Use the strategy for all nodes
+    for (auto& node : nodes) {
+        node.randomize(gen, packetSizeDist);
     }
 
-    // Reset backoff time using the strategy pattern
-    void resetBackoffTime(std::mt19937& gen, int collisionCount, int successfulCount) {
-        if (backoffStrategy) {
-            backoffTime = backoffStrategy->calculateBackoffTime(gen, collisionCount, successfulCount);
-        }
+    Transmissions transmissions{};
+    std::int64_t successful = 0;
+    std::int64_t collisions = 0;
+
+    if (metrics) {
+        metrics->begin();
     }
 
-    // Simulate node behavior for a time unit
-    void simulateTimeUnit() {
-        if (backoffTime > 0) {
-            backoffTime--;
-            isReadyToTransmit = backoffTime == 0;
+    // Simulate each time unit
+    for (std::int64_t time = 0; time < simulationTime; ++time) {
+        int transmittingNodes = 0;
+        std::vector<int> transmittingIndices;
+
+        // Determine which nodes are ready to transmit
+        for (int i = 0; i < numberNodes; ++i) {
+            if (nodes[i].isReadyToTransmit) {
+                transmittingNodes++;
+                transmittingIndices.push_back(i);
+            }
+        }
+
+        if (transmittingNodes == 1) {
+            // Successful transmission
+            successful++;
+            nodes[transmittingIndices[0]].isReadyToTransmit = false; // Transmission complete
+        }
+        else if (transmittingNodes > 1) {
+            // Collision detected
+            collisions++;
+            for (int idx : transmittingIndices) {
+                nodes[idx].resetBackoffTime(gen, collisions, successful); // Apply exponential backoff
+            }
+        }
+
+        if (metrics) {
+            metrics->recordSlot(transmittingNodes);
+        }
+
+        // Simulate passage of time for each node
+        for (auto& node : nodes) {
+            node.simulateTimeUnit();
         }
     }
-};
 
+    if (metrics) {
+        metrics->end();
+    }
 
-Simulator::Simulator(int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, int simulationTime, int numSimulations)
-    :numberNodes(numberNodes), minPacketSize(minPacketSize), maxPacketSize(maxPacketSize), simulationTime(simulationTime), numSimulations(numSimulations)
-{
+    transmissions.collisions = collisions;
+    transmissions.successful = successful;
+
+    return transmissions;
 }
 
-Transmissions Simulator::simulateCSMACA(int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, int simulationTime, int simulations) const
+// Same per-slot engine as above, running on a reusable context so that steady-state
+// replicas perform no heap allocations.
+Transmissions Simulator::simulateCSMACA(SimulationContext& context, int numberNodes, BackoffStrategy* backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, WindowedMetrics* metrics, TraceWriter* trace) const
 {
-    std::normal_distribution<double> distribution(0, 1);
+    std::mt19937& gen = context.getGenerator();
+    std::uniform_int_distribution<> packetSizeDist(minPacketSize, maxPacketSize);
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> packetSizeDist(minPacketSize, maxPacketSize); 
-
-    std::vector<Node> nodes(numberNodes, Node(std::move(backoffStrategy))); // Use the strategy for all nodes
+    context.reset(numberNodes, backoffStrategy);
+    std::pmr::vector<Node>& nodes = context.getNodes();
+    std::pmr::vector<int>& transmittingIndices = context.getTransmittingIndices();
     for (auto& node : nodes) {
         node.randomize(gen, packetSizeDist);
     }
 
     Transmissions transmissions{};
-    int successful = 0;
-    int collisions = 0;
+    std::int64_t successful = 0;
+    std::int64_t collisions = 0;
+
+    if (metrics) {
+        metrics->begin();
+    }
 
     // Simulate each time unit
-    for (int time = 0; time < simulationTime; ++time) {
-        int transmittingNodes = 0;
-        std::vector<int> transmittingIndices;
+    for (std::int64_t time = 0; time < simulationTime; ++time) {
+        transmittingIndices.clear();
 
         // Determine which nodes are ready to transmit
         for (int i = 0; i < numberNodes; ++i) {
             if (nodes[i].isReadyToTransmit) {
-                transmittingNodes++;
                 transmittingIndices.push_back(i);
             }
         }
 
+        int transmittingNodes = static_cast<int>(transmittingIndices.size());
         if (transmittingNodes == 1) {
             // Successful transmission
             successful++;
             nodes[transmittingIndices[0]].isReadyToTransmit = false; // Transmission complete
+            if (trace) {
+                trace->recordSuccess(time, transmittingIndices[0]);
+            }
         }
         else if (transmittingNodes > 1) {
             // Collision detected
@@ -79,6 +130,13 @@ Transmissions Simulator::simulateCSMACA(int numberNodes, std::shared_ptr<Backoff
             for (int idx : transmittingIndices) {
                 nodes[idx].resetBackoffTime(gen, collisions, successful); // Apply exponential backoff
             }
+            if (trace) {
+                trace->recordCollision(time, transmittingIndices.data(), transmittingNodes);
+            }
+        }
+
+        if (metrics) {
+            metrics->recordSlot(transmittingNodes);
         }
 
         // Simulate passage of time for each node
@@ -87,13 +145,161 @@ Transmissions Simulator::simulateCSMACA(int numberNodes, std::shared_ptr<Backoff
         }
     }
 
+    if (metrics) {
+        metrics->end();
+    }
+
     transmissions.collisions = collisions;
     transmissions.successful = successful;
 
     return transmissions;
 }
 
-void Simulator::setParameters(int _numberNodes, std::shared_ptr<BackoffStrategy> _backoffStrategy, int _minPacketSize, int _maxPacketSize, double _simulationTime, int _numSimulations)
+// EDCA runs saturated: every enabled access category always has a frame queued. Rather than
+// stepping each category every slot, each contention round jumps straight over the idle slots
+// to the earliest category whose AIFS + backoff expires, so the cost per idle slot does not
+// grow with the number of categories. Queues, scratch and the generator come from the
+// caller's context, so runs can be reproduced and warm replicas do not allocate; metrics and
+// trace receive the same slot outcomes as in the CSMA/CA engine.
+EdcaTransmissions Simulator::simulateEDCA(SimulationContext& context, int numberNodes, const EdcaConfiguration& configuration, std::int64_t simulationTime, WindowedMetrics* metrics, TraceWriter* trace) const
+{
+    std::mt19937& gen = context.getGenerator();
+    EdcaTransmissions transmissions{};
+
+    if (metrics) {
+        metrics->begin();
+    }
+
+    std::array<int, AC_COUNT> aifsn{};
+    std::array<bool, AC_COUNT> enabled{};
+    for (int ac = 0; ac < AC_COUNT; ++ac) {
+        aifsn[ac] = configuration.getParameters(ac).aifsn;
+        enabled[ac] = configuration.isEnabled(ac);
+    }
+
+    context.resetEdca(numberNodes);
+    std::pmr::vector<EdcaQueue>& queues = context.getEdcaQueues();
+    std::pmr::vector<int>& winners = context.getEdcaWinners(); // Queue index of each node's transmitting category
+    std::pmr::vector<int>& transmitters = context.getTransmittingIndices(); // Node ids of the winners, ascending, for the trace
+    for (int i = 0; i < numberNodes; ++i) {
+        for (int ac = 0; ac < AC_COUNT; ++ac) {
+            if (enabled[ac]) {
+                queues[i * AC_COUNT + ac].backoff = configuration.drawBackoff(gen, ac, 0);
+            }
+        }
+    }
+
+    // Count a failed attempt, dropping the frame once the retry limit is exceeded
+    auto retryOrDrop = [&](EdcaQueue& queue, int ac) {
+        queue.retry++;
+        if (queue.retry > EdcaConfiguration::retryLimit) {
+            transmissions.classes[ac].dropped++;
+            queue.retry = 0;
+        }
+        queue.backoff = configuration.drawBackoff(gen, ac, queue.retry);
+    };
+
+    std::int64_t time = 0;
+    while (time < simulationTime) {
+        // Idle slots until the earliest category is allowed to transmit
+        int wait = INT_MAX;
+        for (std::size_t q = 0; q < queues.size(); ++q) {
+            int ac = static_cast<int>(q % AC_COUNT);
+            if (enabled[ac]) {
+                wait = std::min(wait, aifsn[ac] + queues[q].backoff);
+            }
+        }
+
+        if (wait == INT_MAX || time + wait >= simulationTime) {
+            break;
+        }
+        if (metrics) {
+            metrics->recordSlots(wait, 0);
+        }
+        time += wait;
+
+        // Resolve internal collisions per node, highest category first
+        winners.clear();
+        transmitters.clear();
+        for (int i = 0; i < numberNodes; ++i) {
+            int winner = -1;
+            for (int ac = AC_COUNT - 1; ac >= 0; --ac) {
+                if (!enabled[ac]) {
+                    continue;
+                }
+
+                EdcaQueue& queue = queues[i * AC_COUNT + ac];
+                if (aifsn[ac] + queue.backoff == wait) {
+                    if (winner < 0) {
+                        winner = i * AC_COUNT + ac;
+                    }
+                    else {
+                        transmissions.classes[ac].internalCollisions++;
+                        retryOrDrop(queue, ac);
+                    }
+                }
+                else {
+                    // Backoff only counts down once AIFS has elapsed
+                    queue.backoff -= std::max(0, wait - aifsn[ac]);
+                }
+            }
+
+            if (winner >= 0) {
+                winners.push_back(winner);
+                transmitters.push_back(i);
+            }
+        }
+
+        if (winners.size() == 1) {
+            // Successful transmission, the winner keeps the channel for its TXOP
+            int ac = winners[0] % AC_COUNT;
+            std::int64_t frames = std::min<std::int64_t>(configuration.getParameters(ac).txopLimit, simulationTime - time);
+            EdcaQueue& queue = queues[winners[0]];
+
+            transmissions.successful += frames;
+            transmissions.classes[ac].successful += frames;
+            queue.retry = 0;
+            queue.backoff = configuration.drawBackoff(gen, ac, 0);
+
+            if (metrics) {
+                metrics->recordSlots(frames, 1);
+            }
+            if (trace) {
+                for (std::int64_t frame = 0; frame < frames; ++frame) {
+                    trace->recordSuccess(time + frame, transmitters[0]);
+                }
+            }
+            time += frames;
+        }
+        else {
+            // Collision detected between nodes
+            transmissions.collisions++;
+            for (int winner : winners) {
+                int ac = winner % AC_COUNT;
+                transmissions.classes[ac].collisions++;
+                retryOrDrop(queues[winner], ac);
+            }
+
+            if (metrics) {
+                metrics->recordSlot(static_cast<int>(winners.size()));
+            }
+            if (trace) {
+                trace->recordCollision(time, transmitters.data(), static_cast<int>(transmitters.size()));
+            }
+            time += 1;
+        }
+    }
+
+    // Trailing idle slots after the last transmission
+    if (metrics) {
+        metrics->recordSlots(simulationTime - std::min(time, simulationTime), 0);
+        metrics->end();
+    }
+
+    return transmissions;
+}
+
+void Simulator::setParameters(int _numberNodes, std::shared_ptr<BackoffStrategy> _backoffStrategy, int _minPacketSize, int _maxPacketSize, std::int64_t _simulationTime, int _numSimulations)
 {
     this->numberNodes = _numberNodes;
     this->backoffStrategy = _backoffStrategy;
@@ -101,4 +307,19 @@ void Simulator::setParameters(int _numberNodes, std::shared_ptr<BackoffStrategy>
     this->maxPacketSize = _maxPacketSize;
     this->simulationTime = _simulationTime;
     this->numSimulations = _numSimulations;
+}
+
+void Simulator::setMetrics(std::shared_ptr<WindowedMetrics> _metrics)
+{
+    this->metrics = _metrics;
+}
+
+void Simulator::setEdcaConfiguration(std::shared_ptr<EdcaConfiguration> _edcaConfiguration)
+{
+    this->edcaConfiguration = _edcaConfiguration;
+}
+
+void Simulator::setTracePath(const std::string& _tracePath)
+{
+    this->tracePath = _tracePath;
 }
\ No newline at end of file
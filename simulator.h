@@ -1,22 +1,32 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <random>
+#include <string>
 #include "backoff.h"
+#include "metrics.h"
+#include "edca.h"
+#include "simulationcontext.h"
+#include "tracewriter.h"
 
 struct Transmissions
 {
-    int successful;
-    int collisions;
+    std::int64_t successful;
+    std::int64_t collisions;
 };
 
 class Simulator {
 public:
-    Simulator(int numberNodes=0, std::shared_ptr<BackoffStrategy> backoffStrategy = nullptr, int minPacketSize=0, int maxPacketSize=0, int simulationTime=0, int numSimulations=0);
-    Transmissions simulateCSMACA(int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, int simulationTime, int simulations) const;
+    Simulator(int numberNodes=0, std::shared_ptr<BackoffStrategy> backoffStrategy = nullptr, int minPacketSize=0, int maxPacketSize=0, std::int64_t simulationTime=0, int numSimulations=0);
+    Transmissions simulateCSMACA(int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, int simulations, WindowedMetrics* metrics = nullptr) const;
+    Transmissions simulateCSMACA(std::mt19937& gen, int numberNodes, std::shared_ptr<BackoffStrategy> backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, int simulations, WindowedMetrics* metrics = nullptr) const;
+    Transmissions simulateCSMACA(SimulationContext& context, int numberNodes, BackoffStrategy* backoffStrategy, int minPacketSize, int maxPacketSize, std::int64_t simulationTime, WindowedMetrics* metrics = nullptr, TraceWriter* trace = nullptr) const;
+    EdcaTransmissions simulateEDCA(SimulationContext& context, int numberNodes, const EdcaConfiguration& configuration, std::int64_t simulationTime, WindowedMetrics* metrics = nullptr, TraceWriter* trace = nullptr) const;
 
 
-    double getNumberNodes() 
+    int getNumberNodes() 
     { 
         return numberNodes; 
     }
@@ -36,7 +46,7 @@ public:
         return maxPacketSize; 
     }
 
-    double getSimulationTime() 
+    std::int64_t getSimulationTime() 
     { 
         return simulationTime; 
     }
@@ -47,16 +57,40 @@ public:
         return numSimulations; 
     }
 
+    // Optional per-window metrics stage, nullptr when disabled.
+    std::shared_ptr<WindowedMetrics> getMetrics()
+    {
+        return metrics;
+    }
+
+    // EDCA access category parameters, nullptr when running single-class CSMA/CA.
+    std::shared_ptr<EdcaConfiguration> getEdcaConfiguration()
+    {
+        return edcaConfiguration;
+    }
+
+    // File the first simulation's slot trace is written to, empty when tracing is off.
+    std::string getTracePath()
+    {
+        return tracePath;
+    }
+
     // Add member functions for setting parameters and performing simulations.
-    void setParameters(int _numberNodes, std::shared_ptr<BackoffStrategy> _backoffStrategy, int _minPacketSize, int _maxPacketSize, double _simulationTime, int _numSimulations);
+    void setParameters(int _numberNodes, std::shared_ptr<BackoffStrategy> _backoffStrategy, int _minPacketSize, int _maxPacketSize, std::int64_t _simulationTime, int _numSimulations);
+    void setMetrics(std::shared_ptr<WindowedMetrics> _metrics);
+    void setEdcaConfiguration(std::shared_ptr<EdcaConfiguration> _edcaConfiguration);
+    void setTracePath(const std::string& _tracePath);
 
 private:
     int numberNodes;
     std::shared_ptr<BackoffStrategy> backoffStrategy;
     int minPacketSize;
     int maxPacketSize;
-    double simulationTime;
+    std::int64_t simulationTime; // Number of slots, 64-bit for long-horizon runs
     int numSimulations; // Number of Monte Carlo simulations
+    std::shared_ptr<WindowedMetrics> metrics;
+    std::shared_ptr<EdcaConfiguration> edcaConfiguration;
+    std::string tracePath;
 
     std::vector<double> finalPrices;
 };
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "tracereader.h"
+#include "tracewriter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+std::uint64_t getLittleEndian(const uchar* in, int bytes)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+std::uint64_t getVarint(const uchar*& in, const uchar* end)
+{
+    std::uint64_t value = 0;
+    int shift = 0;
+    while (in < end && shift < 64) {
+        uchar byte = *in++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+        shift += 7;
+    }
+    return value;
+}
+
+} // namespace
+
+TraceReader::TraceReader(const QString& path)
+    : file(path), data(nullptr), size(0), numberNodes(0), totalSlots(0)
+{
+    if (!file.open(QIODevice::ReadOnly) || file.size() < static_cast<qint64>(trace::fileHeaderSize)) {
+        return;
+    }
+
+    size = file.size();
+    data = file.map(0, size);
+    if (!data || std::memcmp(data, trace::magic, 4) != 0 || getLittleEndian(data + 4, 4) != trace::version) {
+        if (data) {
+            file.unmap(data);
+            data = nullptr;
+        }
+        return;
+    }
+
+    numberNodes = static_cast<int>(getLittleEndian(data + 8, 4));
+    totalSlots = static_cast<std::int64_t>(getLittleEndian(data + 16, 8));
+    std::uint64_t blockCount = getLittleEndian(data + 24, 8);
+
+    // Walk the block headers only, skipping over each payload
+    blocks.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(blockCount, size / trace::blockHeaderSize)));
+    qint64 offset = trace::fileHeaderSize;
+    while (offset + static_cast<qint64>(trace::blockHeaderSize) <= size) {
+        const uchar* header = data + offset;
+        BlockIndex block;
+        block.firstSlot = static_cast<std::int64_t>(getLittleEndian(header, 8));
+        block.slotCount = static_cast<std::int64_t>(getLittleEndian(header + 8, 8));
+        block.events = static_cast<std::uint32_t>(getLittleEndian(header + 16, 4));
+        block.payloadBytes = static_cast<std::uint32_t>(getLittleEndian(header + 20, 4));
+        block.successes = static_cast<std::int64_t>(getLittleEndian(header + 24, 8));
+        block.collisions = static_cast<std::int64_t>(getLittleEndian(header + 32, 8));
+        block.payloadOffset = offset + trace::blockHeaderSize;
+
+        if (block.payloadOffset + block.payloadBytes > size) {
+            break; // Truncated trace, keep the complete blocks
+        }
+        blocks.push_back(block);
+        offset = block.payloadOffset + block.payloadBytes;
+    }
+
+    // An unclosed trace has no totals in its header; fall back to the blocks that were written
+    if (!blocks.empty()) {
+        totalSlots = std::max(totalSlots, blocks.back().firstSlot + blocks.back().slotCount);
+    }
+}
+
+TraceReader::~TraceReader()
+{
+    if (data) {
+        file.unmap(data);
+    }
+}
+
+std::size_t TraceReader::findBlock(std::int64_t slot) const
+{
+    // Last block starting at or before the slot
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), slot,
+        [](std::int64_t value, const BlockIndex& block) { return value < block.firstSlot; });
+    return it == blocks.begin() ? 0 : static_cast<std::size_t>(it - blocks.begin() - 1);
+}
+
+void TraceReader::decodeBlock(const BlockIndex& block, const std::function<void(const TraceEvent&)>& visit) const
+{
+    const uchar* in = data + block.payloadOffset;
+    const uchar* end = in + block.payloadBytes;
+
+    std::vector<int> transmitters;
+    transmitters.reserve(numberNodes);
+
+    std::int64_t slot = block.firstSlot;
+    for (std::uint32_t e = 0; e < block.events && in < end; ++e) {
+        std::uint64_t head = getVarint(in, end);
+        slot += static_cast<std::int64_t>(head >> 1);
+        bool collision = (head & 1) != 0;
+
+        transmitters.clear();
+        if (collision) {
+            std::uint64_t count = getVarint(in, end);
+            int id = 0;
+            for (std::uint64_t i = 0; i < count && in < end; ++i) {
+                id += static_cast<int>(getVarint(in, end));
+                transmitters.push_back(id);
+            }
+        }
+        else {
+            transmitters.push_back(static_cast<int>(getVarint(in, end)));
+        }
+
+        visit(TraceEvent{ slot, collision ? TRACE_COLLISION : TRACE_SUCCESS, transmitters });
+    }
+}
+
+void TraceReader::forEach(std::int64_t firstSlot, std::int64_t lastSlot, int outcomeMask, int node,
+    const std::function<void(const TraceEvent&)>& visit) const
+{
+    if (!isOpen() || firstSlot >= lastSlot) {
+        return;
+    }
+
+    for (std::size_t b = findBlock(firstSlot); b < blocks.size() && blocks[b].firstSlot < lastSlot; ++b) {
+        decodeBlock(blocks[b], [&](const TraceEvent& event) {
+            if (event.slot < firstSlot || event.slot >= lastSlot || (event.outcome & outcomeMask) == 0) {
+                return;
+            }
+            if (node >= 0 && std::find(event.transmitters.begin(), event.transmitters.end(), node) == event.transmitters.end()) {
+                return;
+            }
+            visit(event);
+        });
+    }
+}
+
+TraceTotals TraceReader::totals(std::int64_t firstSlot, std::int64_t lastSlot) const
+{
+    TraceTotals result{ 0, 0, 0, 0 };
+    firstSlot = std::max<std::int64_t>(0, firstSlot);
+    lastSlot = std::min(lastSlot, totalSlots);
+    if (!isOpen() || firstSlot >= lastSlot) {
+        return result;
+    }
+
+    for (std::size_t b = findBlock(firstSlot); b < blocks.size() && blocks[b].firstSlot < lastSlot; ++b) {
+        const BlockIndex& block = blocks[b];
+        if (block.firstSlot >= firstSlot && block.firstSlot + block.slotCount <= lastSlot) {
+            // Block lies entirely inside the range, use its header counts
+            result.successful += block.successes;
+            result.collisions += block.collisions;
+        }
+        else {
+            decodeBlock(block, [&](const TraceEvent& event) {
+                if (event.slot >= firstSlot && event.slot < lastSlot) {
+                    (event.outcome == TRACE_COLLISION ? result.collisions : result.successful)++;
+                }
+            });
+        }
+    }
+
+    result.slotCount = lastSlot - firstSlot;
+    result.idle = result.slotCount - result.successful - result.collisions;
+    return result;
+}
+
+std::vector<MetricsWindow> TraceReader::aggregate(std::int64_t windowSlots) const
+{
+    std::vector<MetricsWindow> windows;
+    if (!isOpen() || windowSlots <= 0 || totalSlots <= 0) {
+        return windows;
+    }
+
+    std::int64_t windowCount = (totalSlots + windowSlots - 1) / windowSlots;
+    windows.reserve(static_cast<std::size_t>(windowCount));
+    for (std::int64_t w = 0; w < windowCount; ++w) {
+        std::int64_t start = w * windowSlots;
+        windows.push_back(MetricsWindow{ start, std::min(windowSlots, totalSlots - start), 0, 0 });
+    }
+
+    for (const BlockIndex& block : blocks) {
+        std::int64_t firstWindow = block.firstSlot / windowSlots;
+        std::int64_t lastWindow = (block.firstSlot + std::max<std::int64_t>(0, block.slotCount - 1)) / windowSlots;
+
+        if (firstWindow == lastWindow && firstWindow < windowCount) {
+            // Whole block falls in one window, no need to decode it
+            windows[firstWindow].successful += block.successes;
+            windows[firstWindow].collisions += block.collisions;
+        }
+        else {
+            decodeBlock(block, [&](const TraceEvent& event) {
+                std::int64_t w = event.slot / windowSlots;
+                if (w < windowCount) {
+                    (event.outcome == TRACE_COLLISION ? windows[w].collisions : windows[w].successful)++;
+                }
+            });
+        }
+    }
+
+    return windows;
+}
+
+std::vector<Point> TraceReader::chartPoints(std::int64_t windowSlots) const
+{
+    std::vector<MetricsWindow> windows = aggregate(windowSlots);
+
+    std::vector<Point> points;
+    points.reserve(windows.size());
+    for (std::size_t w = 0; w < windows.size(); ++w) {
+        points.push_back(Point(static_cast<int>(w), windows[w].collisions));
+    }
+    return points;
+}
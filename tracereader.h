@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "metrics.h"
+#include "simulation.h"
+
+// Outcome flags used to filter trace events
+enum TraceOutcome {
+    TRACE_SUCCESS = 1,
+    TRACE_COLLISION = 2,
+    TRACE_ALL = TRACE_SUCCESS | TRACE_COLLISION
+};
+
+// One decoded success or collision; transmitters is only valid during the callback
+struct TraceEvent
+{
+    std::int64_t slot;
+    TraceOutcome outcome;
+    const std::vector<int>& transmitters;
+};
+
+struct TraceTotals
+{
+    std::int64_t slotCount;
+    std::int64_t successful;
+    std::int64_t collisions;
+    std::int64_t idle;
+};
+
+// TraceReader Class
+//
+// Memory-maps a trace written by TraceWriter and builds an index of block headers on open.
+// Seeking uses the index to jump straight to the block holding a slot. Totals and windowed
+// aggregates take whole-block counts from the headers where possible and only decode
+// blocks that straddle a boundary, so traces of billions of slots are never loaded whole.
+class TraceReader {
+public:
+    explicit TraceReader(const QString& path);
+    ~TraceReader();
+
+    bool isOpen() const
+    {
+        return data != nullptr;
+    }
+
+    int getNumberNodes() const
+    {
+        return numberNodes;
+    }
+
+    std::int64_t getTotalSlots() const
+    {
+        return totalSlots;
+    }
+
+    // Visit events in [firstSlot, lastSlot) whose outcome is in outcomeMask, optionally only
+    // those involving the given node (-1 for any node).
+    void forEach(std::int64_t firstSlot, std::int64_t lastSlot, int outcomeMask, int node,
+        const std::function<void(const TraceEvent&)>& visit) const;
+
+    TraceTotals totals(std::int64_t firstSlot, std::int64_t lastSlot) const;
+
+    // Successes and collisions per window of windowSlots across the whole trace.
+    std::vector<MetricsWindow> aggregate(std::int64_t windowSlots) const;
+
+    // Collisions per window in the form used by the chart view.
+    std::vector<Point> chartPoints(std::int64_t windowSlots) const;
+
+private:
+    struct BlockIndex {
+        std::int64_t firstSlot;
+        std::int64_t slotCount;
+        std::uint32_t events;
+        std::uint32_t payloadBytes;
+        std::int64_t successes;
+        std::int64_t collisions;
+        qint64 payloadOffset;
+    };
+
+    QFile file;
+    uchar* data;
+    qint64 size;
+    int numberNodes;
+    std::int64_t totalSlots;
+    std::vector<BlockIndex> blocks;
+
+    std::size_t findBlock(std::int64_t slot) const;
+    void decodeBlock(const BlockIndex& block, const std::function<void(const TraceEvent&)>& visit) const;
+};
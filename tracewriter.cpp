@@ -0,0 +1,181 @@
+#include "tracewriter.h"
+#include <algorithm>
+
+namespace {
+
+// Maximum encoded size of a 64-bit varint
+const std::size_t maxVarintBytes = 10;
+
+void putLittleEndian(std::uint8_t* out, std::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(const std::string& path, int numberNodes, std::size_t blockBytes, int bufferCount)
+    : file(path, std::ios::out | std::ios::binary | std::ios::trunc), numberNodes(numberNodes), blockCount(0), closed(false), failed(false), stopping(false)
+{
+    // Nothing to write to; callers check isOpen() and must not record events
+    if (!file.is_open()) {
+        closed = true;
+        failed = true;
+        return;
+    }
+
+    // A block must always have room for a collision involving every node
+    blockCapacity = std::max(blockBytes, trace::blockHeaderSize + 2 * maxVarintBytes + numberNodes * maxVarintBytes);
+
+    for (int i = 0; i < std::max(2, bufferCount) - 1; ++i) {
+        Block block;
+        block.bytes.reserve(blockCapacity);
+        pool.push_back(std::move(block));
+    }
+    current.bytes.reserve(blockCapacity);
+    current.bytes.resize(trace::blockHeaderSize);
+
+    // Header totals are patched in by close()
+    std::uint8_t header[trace::fileHeaderSize] = {};
+    std::copy(trace::magic, trace::magic + 4, header);
+    putLittleEndian(header + 4, trace::version, 4);
+    putLittleEndian(header + 8, static_cast<std::uint32_t>(numberNodes), 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    writer = std::thread(&TraceWriter::writeLoop, this);
+}
+
+TraceWriter::~TraceWriter()
+{
+    if (!closed) {
+        close(current.lastEventSlot + 1);
+    }
+}
+
+void TraceWriter::putVarint(std::uint64_t value)
+{
+    while (value >= 0x80) {
+        current.bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    current.bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+void TraceWriter::beginEvent(std::int64_t slot, bool collision, std::size_t maxBytes)
+{
+    if (current.bytes.size() + maxBytes > blockCapacity) {
+        finishBlock(slot);
+    }
+
+    std::int64_t previous = current.events == 0 ? current.firstSlot : current.lastEventSlot;
+    putVarint((static_cast<std::uint64_t>(slot - previous) << 1) | (collision ? 1u : 0u));
+    current.lastEventSlot = slot;
+    current.events++;
+}
+
+void TraceWriter::recordSuccess(std::int64_t slot, int transmitter)
+{
+    beginEvent(slot, false, 2 * maxVarintBytes);
+    putVarint(static_cast<std::uint64_t>(transmitter));
+    current.successes++;
+}
+
+void TraceWriter::recordCollision(std::int64_t slot, const int* transmitters, int count)
+{
+    beginEvent(slot, true, (2 + static_cast<std::size_t>(count)) * maxVarintBytes);
+    putVarint(static_cast<std::uint64_t>(count));
+
+    int previous = 0;
+    for (int i = 0; i < count; ++i) {
+        putVarint(static_cast<std::uint64_t>(transmitters[i] - previous));
+        previous = transmitters[i];
+    }
+    current.collisions++;
+}
+
+void TraceWriter::finishBlock(std::int64_t endSlot)
+{
+    std::uint8_t* header = current.bytes.data();
+    putLittleEndian(header, static_cast<std::uint64_t>(current.firstSlot), 8);
+    putLittleEndian(header + 8, static_cast<std::uint64_t>(endSlot - current.firstSlot), 8);
+    putLittleEndian(header + 16, current.events, 4);
+    putLittleEndian(header + 20, static_cast<std::uint32_t>(current.bytes.size() - trace::blockHeaderSize), 4);
+    putLittleEndian(header + 24, static_cast<std::uint64_t>(current.successes), 8);
+    putLittleEndian(header + 32, static_cast<std::uint64_t>(current.collisions), 8);
+    blockCount++;
+
+    // Hand the block to the writer thread and take a recycled buffer, waiting if none is free
+    Block next;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        pending.push_back(std::move(current));
+        condition.notify_all();
+        condition.wait(lock, [this] { return !pool.empty(); });
+        next = std::move(pool.front());
+        pool.pop_front();
+    }
+
+    next.bytes.resize(trace::blockHeaderSize);
+    next.firstSlot = endSlot;
+    next.lastEventSlot = endSlot;
+    next.events = 0;
+    next.successes = 0;
+    next.collisions = 0;
+    current = std::move(next);
+}
+
+void TraceWriter::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        condition.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;
+        }
+
+        Block block = std::move(pending.front());
+        pending.pop_front();
+
+        // Write without holding the lock so the simulation can keep filling blocks
+        lock.unlock();
+        file.write(reinterpret_cast<const char*>(block.bytes.data()), static_cast<std::streamsize>(block.bytes.size()));
+        lock.lock();
+
+        if (file.fail()) {
+            failed = true;
+        }
+
+        pool.push_back(std::move(block));
+        condition.notify_all();
+    }
+}
+
+bool TraceWriter::close(std::int64_t totalSlots)
+{
+    if (closed) {
+        return !failed;
+    }
+    closed = true;
+
+    // Always emit a final block so the trace covers every simulated slot
+    finishBlock(std::max(totalSlots, current.lastEventSlot + (current.events > 0 ? 1 : 0)));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    writer.join();
+
+    std::uint8_t totals[16];
+    putLittleEndian(totals, static_cast<std::uint64_t>(std::max(totalSlots, current.firstSlot)), 8);
+    putLittleEndian(totals + 8, static_cast<std::uint64_t>(blockCount), 8);
+    file.seekp(16);
+    file.write(reinterpret_cast<const char*>(totals), sizeof(totals));
+    file.close();
+    if (file.fail()) {
+        failed = true;
+    }
+    return !failed;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Trace File Format
+//
+// Little-endian binary log of per-slot channel outcomes for one simulation run.
+//
+// File Header (32 bytes) : magic "WFTR", version, number of nodes, reserved, total slots and
+// block count. The totals are patched in when the writer is closed.
+//
+// Block Header (40 bytes) : first slot, slots covered, event count, payload bytes, successes
+// and collisions. Idle slots are implicit (slots covered - successes - collisions), so a
+// reader can seek and aggregate whole blocks without decoding them.
+//
+// Events : Only successes and collisions are stored. Each event starts with a varint holding
+// (slot delta << 1 | collision bit), where the delta is taken from the previous event in the
+// block (the block's first slot for the first event). A success is followed by the
+// transmitter id; a collision by the transmitter count and the ascending ids, delta-coded.
+// All ids and counts are varints.
+namespace trace {
+    const char magic[4] = { 'W', 'F', 'T', 'R' };
+    const std::uint32_t version = 1;
+    const std::size_t fileHeaderSize = 32;
+    const std::size_t blockHeaderSize = 40;
+}
+
+// TraceWriter Class
+//
+// Records slot outcomes from the simulation loop into fixed-size blocks. Full blocks are
+// handed to a background thread that writes them to disk, so the simulation only blocks when
+// every buffer in the pool is waiting to be written. Block buffers are recycled rather than
+// reallocated.
+class TraceWriter {
+public:
+    TraceWriter(const std::string& path, int numberNodes, std::size_t blockBytes = 64 * 1024, int bufferCount = 4);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // False if the trace file could not be created; no writer thread is started in that case.
+    bool isOpen() const
+    {
+        return file.is_open();
+    }
+
+    void recordSuccess(std::int64_t slot, int transmitter);
+    // Transmitter ids must be in ascending order.
+    void recordCollision(std::int64_t slot, const int* transmitters, int count);
+
+    // Flush the final block covering up to totalSlots, stop the writer thread and patch the header.
+    // Returns false if the file was never opened or any write to it failed.
+    bool close(std::int64_t totalSlots);
+
+private:
+    struct Block {
+        std::vector<std::uint8_t> bytes; // Block header followed by the event payload
+        std::int64_t firstSlot = 0;
+        std::int64_t lastEventSlot = 0;
+        std::uint32_t events = 0;
+        std::int64_t successes = 0;
+        std::int64_t collisions = 0;
+    };
+
+    std::ofstream file;
+    int numberNodes;
+    std::size_t blockCapacity;
+    std::int64_t blockCount;
+    Block current;
+    bool closed;
+    bool failed; // Set by the writer thread or close() when the stream reports an error
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Block> pending; // Full blocks waiting for the writer thread
+    std::deque<Block> pool;    // Written blocks available for reuse
+    bool stopping;
+    std::thread writer;
+
+    void beginEvent(std::int64_t slot, bool collision, std::size_t maxBytes);
+    void putVarint(std::uint64_t value);
+    void finishBlock(std::int64_t endSlot);
+    void writeLoop();
+};
@@ -0,0 +1,56 @@
+#include "validation.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Global heap allocation counter. Replacing operator new here counts every plain and array
+// allocation in the program, whichever container, strategy or metrics stage makes it.
+namespace {
+std::atomic<std::int64_t> heapAllocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+std::int64_t heapAllocationCount()
+{
+    return heapAllocations.load(std::memory_order_relaxed);
+}
+
+// Console entry point for the engine validation target; exits non-zero if any check fails
+int main()
+{
+    return runValidation(std::cout) ? 0 : 1;
+}
@@ -0,0 +1,433 @@
+#include "validation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+const int minPacketSize = 64;
+const int maxPacketSize = 1500;
+
+// Two-sample Kolmogorov-Smirnov statistic D = sup |F1(x) - F2(x)|
+double ksStatistic(std::vector<std::int64_t> a, std::vector<std::int64_t> b)
+{
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+
+    double d = 0.0;
+    std::size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        std::int64_t x = std::min(a[i], b[j]);
+        while (i < a.size() && a[i] == x) ++i;
+        while (j < b.size() && b[j] == x) ++j;
+        d = std::max(d, std::abs(static_cast<double>(i) / a.size() - static_cast<double>(j) / b.size()));
+    }
+    return d;
+}
+
+// Chi-square homogeneity statistic over equal-frequency bins of the pooled sample.
+// Returns the statistic and sets degreesOfFreedom to the number of bins used minus one.
+double chiSquareStatistic(const std::vector<std::int64_t>& a, const std::vector<std::int64_t>& b, int& degreesOfFreedom)
+{
+    std::vector<std::int64_t> pooled(a);
+    pooled.insert(pooled.end(), b.begin(), b.end());
+    std::sort(pooled.begin(), pooled.end());
+
+    // Aim for at least five expected observations per cell; ties collapse duplicate edges
+    int bins = std::max(1, std::min(10, static_cast<int>(std::min(a.size(), b.size()) / 5)));
+    std::vector<std::int64_t> edges;
+    for (int k = 1; k < bins; ++k) {
+        std::int64_t edge = pooled[pooled.size() * k / bins];
+        if (edges.empty() || edge > edges.back()) {
+            edges.push_back(edge);
+        }
+    }
+
+    std::vector<double> countA(edges.size() + 1, 0.0), countB(edges.size() + 1, 0.0);
+    auto binOf = [&](std::int64_t x) {
+        return static_cast<std::size_t>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+    };
+    for (std::int64_t x : a) countA[binOf(x)]++;
+    for (std::int64_t x : b) countB[binOf(x)]++;
+
+    double total = static_cast<double>(pooled.size());
+    double chi = 0.0;
+    int used = 0;
+    for (std::size_t k = 0; k < countA.size(); ++k) {
+        double column = countA[k] + countB[k];
+        if (column == 0.0) {
+            continue;
+        }
+        used++;
+        double expectedA = column * a.size() / total;
+        double expectedB = column * b.size() / total;
+        chi += (countA[k] - expectedA) * (countA[k] - expectedA) / expectedA;
+        chi += (countB[k] - expectedB) * (countB[k] - expectedB) / expectedB;
+    }
+
+    degreesOfFreedom = std::max(0, used - 1);
+    return chi;
+}
+
+// Upper 1% point of the chi-square distribution (Wilson-Hilferty approximation)
+double chiSquareCritical(int degreesOfFreedom)
+{
+    if (degreesOfFreedom <= 0) {
+        return 0.0;
+    }
+    const double z = 2.326; // Standard normal 99th percentile
+    double k = degreesOfFreedom;
+    double term = 1.0 - 2.0 / (9.0 * k) + z * std::sqrt(2.0 / (9.0 * k));
+    return k * term * term * term;
+}
+
+// Run warm replicas through the context engine, with windowed metrics enabled, and report
+// every heap allocation made while they run. The steady-state loop must make none.
+bool checkSteadyStateAllocations(std::ostream& out, int replicas = 100, int numberNodes = 100, std::int64_t simulationTime = 1000)
+{
+    bool passed = true;
+    Simulator simulator;
+    SimulationContext context(numberNodes);
+    WindowedMetrics metrics(100);
+
+    for (const char* strategyName : { "Exponential", "BEB", "AdaptiveRate" }) {
+        std::unique_ptr<BackoffStrategy> strategy = EquivalenceHarness::makeStrategy(strategyName);
+
+        // Warm-up replica sizes every buffer
+        simulator.simulateCSMACA(context, numberNodes, strategy.get(), minPacketSize, maxPacketSize, simulationTime, &metrics);
+
+        std::int64_t before = heapAllocationCount();
+        for (int replica = 0; replica < replicas; ++replica) {
+            simulator.simulateCSMACA(context, numberNodes, strategy.get(), minPacketSize, maxPacketSize, simulationTime, &metrics);
+        }
+        std::int64_t allocations = heapAllocationCount() - before;
+
+        out << (allocations == 0 ? "PASS" : "FAIL") << "  Context  Strategy: " << strategyName << "  Nodes: " << numberNodes
+            << "  Heap Allocations: " << allocations << " over " << replicas << " replicas" << std::endl;
+        passed = passed && allocations == 0;
+    }
+
+    // EDCA replicas draw their queues and scratch from the same context
+    EdcaConfiguration configuration;
+    simulator.simulateEDCA(context, numberNodes, configuration, simulationTime, &metrics);
+
+    std::int64_t before = heapAllocationCount();
+    for (int replica = 0; replica < replicas; ++replica) {
+        simulator.simulateEDCA(context, numberNodes, configuration, simulationTime, &metrics);
+    }
+    std::int64_t allocations = heapAllocationCount() - before;
+
+    out << (allocations == 0 ? "PASS" : "FAIL") << "  EDCA  Nodes: " << numberNodes
+        << "  Heap Allocations: " << allocations << " over " << replicas << " replicas" << std::endl;
+    passed = passed && allocations == 0;
+
+    return passed;
+}
+
+// EDCA models a different protocol from the reference, so it cannot be compared against it.
+// The checks below test properties any correct EDCA engine must have.
+
+// A single node with a single enabled category has nobody to collide with, inside or outside the node.
+bool checkEdcaSingleClass(std::ostream& out, int replicas = 20, std::int64_t simulationTime = 10000)
+{
+    Simulator simulator;
+    SimulationContext context;
+    bool passed = true;
+
+    for (int only = 0; only < AC_COUNT; ++only) {
+        EdcaConfiguration configuration;
+        for (int ac = 0; ac < AC_COUNT; ++ac) {
+            configuration.setEnabled(static_cast<AccessCategory>(ac), ac == only);
+        }
+
+        EdcaClassStats total{ 0, 0, 0, 0 };
+        for (int replica = 0; replica < replicas; ++replica) {
+            context.seed(static_cast<std::uint32_t>(replica));
+            EdcaTransmissions result = simulator.simulateEDCA(context, 1, configuration, simulationTime);
+            for (int ac = 0; ac < AC_COUNT; ++ac) {
+                total.successful += result.classes[ac].successful;
+                total.collisions += result.classes[ac].collisions;
+                total.internalCollisions += result.classes[ac].internalCollisions;
+            }
+        }
+
+        bool ok = total.collisions == 0 && total.internalCollisions == 0 && total.successful > 0;
+        out << (ok ? "PASS" : "FAIL") << "  EDCA  Single Node, Category " << only << " Only  Successful: " << total.successful
+            << "  Collisions: " << total.collisions << "  Internal Collisions: " << total.internalCollisions << std::endl;
+        passed = passed && ok;
+    }
+
+    return passed;
+}
+
+// With equal contention windows, a category with a smaller AIFSN starts counting down sooner and
+// must not get less throughput than one with a larger AIFSN. The smaller AIFSN is given to the
+// lower category, so winning internal collisions cannot explain the result.
+bool checkEdcaAifsnPriority(std::ostream& out, int replicas = 20, int numberNodes = 10, std::int64_t simulationTime = 10000)
+{
+    Simulator simulator;
+    SimulationContext context;
+    EdcaConfiguration configuration;
+    configuration.setParameters(AC_BK, EdcaParameters{ 2, 15, 1023, 1 });
+    configuration.setParameters(AC_BE, EdcaParameters{ 7, 15, 1023, 1 });
+    configuration.setEnabled(AC_VI, false);
+    configuration.setEnabled(AC_VO, false);
+
+    std::int64_t shortAifs = 0;
+    std::int64_t longAifs = 0;
+    for (int replica = 0; replica < replicas; ++replica) {
+        context.seed(static_cast<std::uint32_t>(replica));
+        EdcaTransmissions result = simulator.simulateEDCA(context, numberNodes, configuration, simulationTime);
+        shortAifs += result.classes[AC_BK].successful;
+        longAifs += result.classes[AC_BE].successful;
+    }
+
+    bool ok = shortAifs >= longAifs;
+    out << (ok ? "PASS" : "FAIL") << "  EDCA  AIFSN Priority  Nodes: " << numberNodes << "  Successful (AIFSN 2): " << shortAifs
+        << "  Successful (AIFSN 7): " << longAifs << std::endl;
+    return ok;
+}
+
+std::uint64_t readLittleEndian(const char* bytes, int size)
+{
+    std::uint64_t value = 0;
+    for (int i = size - 1; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+// Totals of the windowed metrics and of the trace file must match the totals the engine returns.
+// The trace is read block header by block header, without decoding events.
+bool checkEdcaObservers(std::ostream& out, int numberNodes = 20, std::int64_t simulationTime = 100000)
+{
+    Simulator simulator;
+    SimulationContext context;
+    EdcaConfiguration configuration;
+    WindowedMetrics metrics(1000, static_cast<std::size_t>(simulationTime / 1000 + 1));
+    std::string path = (std::filesystem::temp_directory_path() / "wifivalidate_trace.bin").string();
+
+    EdcaTransmissions result{};
+    bool traceWritten = false;
+    {
+        TraceWriter trace(path, numberNodes);
+        if (trace.isOpen()) {
+            context.seed(1);
+            result = simulator.simulateEDCA(context, numberNodes, configuration, simulationTime, &metrics, &trace);
+            traceWritten = trace.close(simulationTime);
+        }
+    }
+    if (!traceWritten) {
+        out << "FAIL  EDCA  Unable to write trace file: " << path << std::endl;
+        return false;
+    }
+
+    MetricsWindow windowTotal{ 0, 0, 0, 0 };
+    for (const MetricsWindow& window : metrics.windows()) {
+        windowTotal.slotCount += window.slotCount;
+        windowTotal.successful += window.successful;
+        windowTotal.collisions += window.collisions;
+    }
+
+    std::int64_t traceSlots = 0;
+    std::int64_t traceSuccessful = 0;
+    std::int64_t traceCollisions = 0;
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> header(trace::blockHeaderSize);
+    file.seekg(trace::fileHeaderSize);
+    while (file.read(header.data(), trace::blockHeaderSize)) {
+        traceSlots += static_cast<std::int64_t>(readLittleEndian(&header[8], 8));
+        traceSuccessful += static_cast<std::int64_t>(readLittleEndian(&header[24], 8));
+        traceCollisions += static_cast<std::int64_t>(readLittleEndian(&header[32], 8));
+        file.seekg(static_cast<std::streamoff>(readLittleEndian(&header[20], 4)), std::ios::cur);
+    }
+    file.close();
+    std::filesystem::remove(path);
+
+    bool metricsOk = metrics.getDroppedWindows() == 0 && windowTotal.slotCount == simulationTime
+        && windowTotal.successful == result.successful && windowTotal.collisions == result.collisions;
+    bool traceOk = traceSlots == simulationTime && traceSuccessful == result.successful && traceCollisions == result.collisions;
+
+    out << (metricsOk ? "PASS" : "FAIL") << "  EDCA  Windowed Metrics  Slots: " << windowTotal.slotCount << "/" << simulationTime
+        << "  Successful: " << windowTotal.successful << "/" << result.successful
+        << "  Collisions: " << windowTotal.collisions << "/" << result.collisions << std::endl;
+    out << (traceOk ? "PASS" : "FAIL") << "  EDCA  Trace  Slots: " << traceSlots << "/" << simulationTime
+        << "  Successful: " << traceSuccessful << "/" << result.successful
+        << "  Collisions: " << traceCollisions << "/" << result.collisions << std::endl;
+    return metricsOk && traceOk;
+}
+
+} // namespace
+
+EquivalenceHarness::EquivalenceHarness(int replicas, std::int64_t simulationTime, std::uint32_t baseSeed)
+    : replicas(replicas), simulationTime(simulationTime), baseSeed(baseSeed)
+{
+    // The original per-slot engine, seeded per replica
+    reference = [](BackoffStrategy* backoffStrategy, int numberNodes, std::int64_t simulationTime, std::uint32_t seed) {
+        Simulator simulator;
+        std::mt19937 gen(seed);
+        // Non-owning: the harness keeps the strategy alive for the duration of the call
+        std::shared_ptr<BackoffStrategy> strategy(backoffStrategy, [](BackoffStrategy*) {});
+        return simulator.simulateCSMACA(gen, numberNodes, strategy, minPacketSize, maxPacketSize, simulationTime, 1);
+    };
+}
+
+void EquivalenceHarness::addEngine(const std::string& name, EngineFunction engine, bool bitwiseComparable)
+{
+    engines.push_back(Engine{ name, std::move(engine), bitwiseComparable });
+}
+
+std::unique_ptr<BackoffStrategy> EquivalenceHarness::makeStrategy(const std::string& name)
+{
+    if (name == "BEB") {
+        return std::make_unique<BinaryExponentialBackoffStrategy>();
+    }
+    else if (name == "AdaptiveRate") {
+        return std::make_unique<AdaptiveRateBackoffStrategy>();
+    }
+    return std::make_unique<ExponentialBackoffStrategy>();
+}
+
+std::vector<ValidationResult> EquivalenceHarness::run(const std::vector<int>& nodeCounts, const std::vector<std::string>& strategies) const
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Run all replicas of one engine, returning per-replica results and elapsed seconds
+    auto runReplicas = [&](const EngineFunction& engine, const std::string& strategyName, int numberNodes, std::uint32_t seedOffset,
+        std::vector<Transmissions>& results) {
+        results.clear();
+        results.reserve(replicas);
+        auto start = Clock::now();
+        for (int replica = 0; replica < replicas; ++replica) {
+            std::unique_ptr<BackoffStrategy> strategy = makeStrategy(strategyName);
+            results.push_back(engine(strategy.get(), numberNodes, simulationTime, baseSeed + seedOffset + replica));
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    auto collisionsOf = [](const std::vector<Transmissions>& results) {
+        std::vector<std::int64_t> collisions;
+        collisions.reserve(results.size());
+        for (const Transmissions& t : results) {
+            collisions.push_back(t.collisions);
+        }
+        return collisions;
+    };
+
+    std::vector<ValidationResult> results;
+    std::vector<Transmissions> referenceRuns, engineRuns;
+
+    for (const std::string& strategyName : strategies) {
+        for (int numberNodes : nodeCounts) {
+            double referenceTime = runReplicas(reference, strategyName, numberNodes, 0, referenceRuns);
+
+            for (const Engine& engine : engines) {
+                ValidationResult result{ engine.name, strategyName, numberNodes, engine.bitwiseComparable, false, 0, 0.0, 0.0, 0.0, 0.0, 0, 0.0 };
+
+                // Bitwise engines share the reference seeds, the rest draw from a disjoint seed range
+                std::uint32_t seedOffset = engine.bitwiseComparable ? 0 : static_cast<std::uint32_t>(replicas);
+                double engineTime = runReplicas(engine.function, strategyName, numberNodes, seedOffset, engineRuns);
+                result.speedup = engineTime > 0.0 ? referenceTime / engineTime : 0.0;
+
+                if (engine.bitwiseComparable) {
+                    for (int replica = 0; replica < replicas; ++replica) {
+                        if (referenceRuns[replica].collisions != engineRuns[replica].collisions
+                            || referenceRuns[replica].successful != engineRuns[replica].successful) {
+                            result.mismatches++;
+                        }
+                    }
+                    result.passed = result.mismatches == 0;
+                }
+                else {
+                    std::vector<std::int64_t> a = collisionsOf(referenceRuns);
+                    std::vector<std::int64_t> b = collisionsOf(engineRuns);
+                    int degreesOfFreedom = 0;
+
+                    const double c = 1.628; // Kolmogorov-Smirnov coefficient for alpha = 0.01
+                    result.ksStatistic = ksStatistic(a, b);
+                    result.ksCritical = c * std::sqrt(static_cast<double>(a.size() + b.size()) / (static_cast<double>(a.size()) * b.size()));
+                    result.chiSquare = chiSquareStatistic(a, b, degreesOfFreedom);
+                    result.chiCritical = chiSquareCritical(degreesOfFreedom);
+                    result.chiDegreesOfFreedom = degreesOfFreedom;
+
+                    // With a single bin the chi-square test has nothing to compare, so only KS decides
+                    bool chiPassed = degreesOfFreedom == 0 || result.chiSquare <= result.chiCritical;
+                    result.passed = result.ksStatistic <= result.ksCritical && chiPassed;
+                }
+
+                results.push_back(result);
+            }
+        }
+    }
+
+    return results;
+}
+
+void EquivalenceHarness::report(std::ostream& out, const std::vector<ValidationResult>& results)
+{
+    int failures = 0;
+    int chiNotApplicable = 0;
+    for (const ValidationResult& result : results) {
+        out << (result.passed ? "PASS" : "FAIL") << "  " << result.engine << "  Strategy: " << result.strategy << "  Nodes: " << result.numberNodes;
+        if (result.bitwise) {
+            out << "  Bitwise Mismatches: " << result.mismatches;
+        }
+        else {
+            out << std::fixed << std::setprecision(4)
+                << "  KS D: " << result.ksStatistic << " (<= " << result.ksCritical << ")";
+            if (result.chiDegreesOfFreedom > 0) {
+                out << "  Chi-Square: " << result.chiSquare << " (<= " << result.chiCritical << ")";
+            }
+            else {
+                out << "  Chi-Square: n/a (dof 0)";
+                chiNotApplicable++;
+            }
+        }
+        out << std::fixed << std::setprecision(2) << "  Speedup: " << result.speedup << "x" << std::endl;
+        out.unsetf(std::ios::floatfield);
+
+        if (!result.passed) {
+            failures++;
+        }
+    }
+    out << results.size() - failures << " of " << results.size() << " checks passed";
+    if (chiNotApplicable > 0) {
+        out << " (" << chiNotApplicable << " decided by KS alone, chi-square not applicable)";
+    }
+    out << std::endl;
+}
+
+bool runValidation(std::ostream& out)
+{
+    EquivalenceHarness harness;
+
+    // Arena-backed context engine: same RNG consumption order as the reference
+    auto context = std::make_shared<SimulationContext>();
+    harness.addEngine("Context", [context](BackoffStrategy* backoffStrategy, int numberNodes, std::int64_t simulationTime, std::uint32_t seed) {
+        Simulator simulator;
+        context->seed(seed);
+        return simulator.simulateCSMACA(*context, numberNodes, backoffStrategy, minPacketSize, maxPacketSize, simulationTime);
+    }, true);
+
+    // Same engine on independent seeds, exercising the distributional tests
+    auto independent = std::make_shared<SimulationContext>();
+    harness.addEngine("Context (Independent Seeds)", [independent](BackoffStrategy* backoffStrategy, int numberNodes, std::int64_t simulationTime, std::uint32_t seed) {
+        Simulator simulator;
+        independent->seed(seed);
+        return simulator.simulateCSMACA(*independent, numberNodes, backoffStrategy, minPacketSize, maxPacketSize, simulationTime);
+    }, false);
+
+    std::vector<ValidationResult> results = harness.run({ 10, 50, 100 }, { "Exponential", "BEB", "AdaptiveRate" });
+    EquivalenceHarness::report(out, results);
+
+    bool allocationsPassed = checkSteadyStateAllocations(out);
+    bool edcaSingleClassPassed = checkEdcaSingleClass(out);
+    bool edcaPriorityPassed = checkEdcaAifsnPriority(out);
+    bool edcaObserversPassed = checkEdcaObservers(out);
+    bool edcaPassed = edcaSingleClassPassed && edcaPriorityPassed && edcaObserversPassed;
+
+    return allocationsPassed && edcaPassed && std::all_of(results.begin(), results.end(), [](const ValidationResult& result) { return result.passed; });
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "simulator.h"
+
+// Runs one replica of an engine with the given strategy, node count, slot count and seed.
+using EngineFunction = std::function<Transmissions(BackoffStrategy* backoffStrategy, int numberNodes, std::int64_t simulationTime, std::uint32_t seed)>;
+
+// Outcome of comparing one engine against the reference for one node count and strategy
+struct ValidationResult
+{
+    std::string engine;
+    std::string strategy;
+    int numberNodes;
+    bool bitwise;          // Compared replica by replica with shared seeds
+    bool passed;
+    int mismatches;        // Bitwise mode: replicas whose counts differ
+    double ksStatistic;    // Distributional mode: two-sample Kolmogorov-Smirnov D
+    double ksCritical;
+    double chiSquare;      // Distributional mode: chi-square homogeneity statistic
+    double chiCritical;
+    int chiDegreesOfFreedom; // 0 when all counts fall in one bin and the test does not apply
+    double speedup;        // Reference time divided by engine time
+};
+
+// EquivalenceHarness Class
+//
+// Checks alternative simulation engines against the reference per-slot engine
+// (Simulator::simulateCSMACA) over a matrix of node counts and backoff strategies.
+//
+// Bitwise Mode : Engines that consume random numbers in the same order as the reference are
+// run with the same seed per replica and must reproduce its success and collision counts exactly.
+//
+// Distributional Mode : Other engines are run on independent seeds and their per-replica
+// collision counts are compared with the reference using a two-sample Kolmogorov-Smirnov test
+// and a chi-square homogeneity test over equal-frequency bins, both at the 1% level.
+//
+// Every strategy instance is created fresh per replica and per engine, since stateful
+// strategies (AdaptiveRate) would otherwise carry state from one run into the next.
+class EquivalenceHarness {
+public:
+    explicit EquivalenceHarness(int replicas = 200, std::int64_t simulationTime = 1000, std::uint32_t baseSeed = 12345);
+
+    void addEngine(const std::string& name, EngineFunction engine, bool bitwiseComparable);
+    std::vector<ValidationResult> run(const std::vector<int>& nodeCounts, const std::vector<std::string>& strategies) const;
+
+    static std::unique_ptr<BackoffStrategy> makeStrategy(const std::string& name);
+    static void report(std::ostream& out, const std::vector<ValidationResult>& results);
+
+private:
+    struct Engine {
+        std::string name;
+        EngineFunction function;
+        bool bitwiseComparable;
+    };
+
+    int replicas;
+    std::int64_t simulationTime;
+    std::uint32_t baseSeed;
+    EngineFunction reference;
+    std::vector<Engine> engines;
+};
+
+// Number of heap allocations made by the program so far. Provided by the program's entry file,
+// which replaces the global operator new to count them (see validatemain.cpp).
+std::int64_t heapAllocationCount();
+
+// Validate every engine shipped with the simulator and check that the context engine's
+// steady-state loop makes no heap allocations. Writes the report and returns true if all passed.
+bool runValidation(std::ostream& out);
@@ -1,11 +1,13 @@
 #include "wifi.h"
+#include "tracereader.h"
+#include <QDir>
 #include <QThread>
 #include <QtCharts>
 #include <sstream>
 #include <ctime>
 
 
-wifi::wifi(QWidget* parent) : QMainWindow(parent), numberNodes(100), minPacketSize(64), maxPacketSize(1500), simulationTime(100), numSimulations(1000)
+wifi::wifi(QWidget* parent) : QMainWindow(parent), numberNodes(100), minPacketSize(64), maxPacketSize(1500), simulationTime(100), numSimulations(1000), metricsWindow(0), metricsCsvEnabled(false), metricsCsvStreaming(false), traceEnabled(false)
 {
     ui.setupUi(this);
     ui.editNumberNodes->setText(QString::number(numberNodes));
@@ -13,6 +15,7 @@ wifi::wifi(QWidget* parent) : QMainWindow(parent), numberNodes(100), minPacketSi
     ui.editMaxPacketSize->setText(QString::number(maxPacketSize));
     ui.editSimulationTime->setText(QString::number(simulationTime));
     ui.editNumSimulations->setText(QString::number(numSimulations));
+    ui.editMetricsWindow->setText(QString::number(metricsWindow));
     ui.progressBar->setRange(0, 100);
     ui.progressBar->setValue(0);
 
@@ -20,6 +23,7 @@ wifi::wifi(QWidget* parent) : QMainWindow(parent), numberNodes(100), minPacketSi
     ui.cbBackoffStrategy->addItem("Exponential");
     ui.cbBackoffStrategy->addItem("BEB");
     ui.cbBackoffStrategy->addItem("AdaptiveRate");
+    ui.cbBackoffStrategy->addItem("EDCA");
 
     connect(ui.buttonExecute, &QPushButton::clicked, this, &wifi::onButtonClicked);
     simThread = nullptr;
@@ -43,6 +47,10 @@ void wifi::initializeThread() {
         connect(sim.get(), &Simulation::finished, sim.get(), &Simulation::deleteLater); // schedule object for deletion
         connect(sim.get(), &Simulation::progressUpdated, this, &wifi::updateProgress);
         connect(sim.get(), &Simulation::collisionDataReady, this, &wifi::createChart);
+        connect(sim.get(), &Simulation::windowDataReady, this, &wifi::showWindowMetrics);
+        connect(sim.get(), &Simulation::edcaDataReady, this, &wifi::showEdcaStatistics);
+        connect(sim.get(), &Simulation::traceReady, this, &wifi::showTrace);
+        connect(sim.get(), &Simulation::traceFailed, this, &wifi::showTraceError);
     }
 }
 
@@ -55,8 +63,11 @@ void wifi::onButtonClicked()
     this->numberNodes = ui.editNumberNodes->text().toInt();
     this->minPacketSize = ui.editMinPacketSize->text().toInt();
     this->maxPacketSize = ui.editMaxPacketSize->text().toInt();
-    this->simulationTime = ui.editSimulationTime->text().toInt();
+    this->simulationTime = ui.editSimulationTime->text().toLongLong();
     this->numSimulations = ui.editNumSimulations->text().toInt();
+    this->metricsWindow = ui.editMetricsWindow->text().toLongLong();
+    this->metricsCsvEnabled = ui.cbMetricsCsv->isChecked();
+    this->traceEnabled = ui.cbTrace->isChecked();
 
     // Determine selected backoff strategy from UI
     this->selectedStrategy = ui.cbBackoffStrategy->currentText();
@@ -70,6 +81,9 @@ void wifi::onButtonClicked()
     else if (this->selectedStrategy == "AdaptiveRate") {
         this->backoffStrategy = std::make_unique<AdaptiveRateBackoffStrategy>();
     }
+    else if (this->selectedStrategy == "EDCA") {
+        this->backoffStrategy = nullptr; // Contention parameters come from the EDCA access categories
+    }
     else {
         // Handle unknown selection or set a default
         this->backoffStrategy = std::make_unique<ExponentialBackoffStrategy>(); // Default case
@@ -88,6 +102,22 @@ void wifi::startSimulation()
 {
     // Pass the updated values to the simulation object
     simulator->setParameters(numberNodes, backoffStrategy, minPacketSize, maxPacketSize, simulationTime, numSimulations);
+    metricsCsvStreaming = false;
+    if (metricsWindow > 0) {
+        // The ring only keeps recent windows; the CSV stream keeps every window of every simulation
+        auto metrics = std::make_shared<WindowedMetrics>(metricsWindow, 1024, metricsCsvEnabled ? metricsCsvPath().toStdString() : "");
+        metricsCsvStreaming = metrics->isStreaming();
+        if (metricsCsvEnabled && !metricsCsvStreaming) {
+            ui.editResult->append("Unable to create metrics CSV: " + metricsCsvPath() + " -- streaming disabled");
+        }
+        simulator->setMetrics(metrics);
+    }
+    if (selectedStrategy == "EDCA") {
+        simulator->setEdcaConfiguration(std::make_shared<EdcaConfiguration>());
+    }
+    if (traceEnabled) {
+        simulator->setTracePath(QDir(QDir::tempPath()).filePath("wifi_trace.bin").toStdString());
+    }
     sim->doWork(std::move(simulator));
 }
 
@@ -138,6 +168,10 @@ void wifi::finishedTask(double value)
 }
 
 void wifi::createChart(const std::vector<Point>& data) {
+    plotChart(data, "Simulations", "Simulation Number", "Number of Collisions");
+}
+
+void wifi::plotChart(const std::vector<Point>& data, const QString& seriesName, const QString& xTitle, const QString& yTitle) {
     // Check if a QChartView already exists in the container
     QChartView* chartView = nullptr;
     if (ui.chartContainer->layout() && ui.chartContainer->layout()->count() > 0) {
@@ -164,7 +198,7 @@ void wifi::createChart(const std::vector<Point>& data) {
 
     // Create new series with the new data
     QLineSeries* series = new QLineSeries();
-    series->setName("Simulations");
+    series->setName(seriesName);
 
     for (const Point& point : data) {
         series->append(static_cast<qreal>(point.simulation), static_cast<qreal>(point.collisions));
@@ -173,6 +207,82 @@ void wifi::createChart(const std::vector<Point>& data) {
     // Add the new series to the chart
     chart->addSeries(series);
     chart->createDefaultAxes();
-    chart->axisX()->setTitleText("Simulation Number");
-    chart->axisY()->setTitleText("Number of Collisions");
+    chart->axisX()->setTitleText(xTitle);
+    chart->axisY()->setTitleText(yTitle);
+}
+
+void wifi::showWindowMetrics(const MetricsSummary& summary)
+{
+    if (summary.windows == 0) {
+        return;
+    }
+
+    // Summarise the last run: compare first and last window and find the most congested one
+    auto rate = [](const MetricsWindow& window) {
+        return window.slotCount > 0 ? static_cast<double>(window.collisions) / window.slotCount : 0.0;
+    };
+
+    std::ostringstream result;
+    result << "Windows: " << summary.windows << " x " << metricsWindow << " slots"
+        << " (" << summary.droppedWindows << " dropped from the in-memory ring)" << std::endl
+        << "Collisions/Slot First Window: " << rate(summary.first) << " Last Window: " << rate(summary.last) << std::endl
+        << "Peak Window Collisions: " << summary.peak.collisions << " at Slot " << summary.peak.startSlot << std::endl;
+    if (metricsCsvStreaming) {
+        result << "Metrics CSV: " << metricsCsvPath().toStdString() << std::endl;
+    }
+
+    ui.editResult->append(result.str().c_str());
+}
+
+QString wifi::metricsCsvPath() const
+{
+    return QDir(QDir::tempPath()).filePath("wifi_metrics.csv");
+}
+
+void wifi::showEdcaStatistics(const EdcaTransmissions& totals)
+{
+    static const char* names[AC_COUNT] = { "AC_BK", "AC_BE", "AC_VI", "AC_VO" };
+
+    // Per access category averages over all simulations
+    std::ostringstream result;
+    for (int ac = 0; ac < AC_COUNT; ++ac) {
+        const EdcaClassStats& stats = totals.classes[ac];
+        result << names[ac] << " -- Avg Successful: " << static_cast<double>(stats.successful) / numSimulations
+            << " Throughput (Frames/Unit): " << static_cast<double>(stats.successful) / (static_cast<double>(simulationTime) * numSimulations)
+            << " Avg Collisions: " << static_cast<double>(stats.collisions) / numSimulations
+            << " Avg Internal Collisions: " << static_cast<double>(stats.internalCollisions) / numSimulations
+            << " Avg Dropped: " << static_cast<double>(stats.dropped) / numSimulations << std::endl;
+    }
+
+    ui.editResult->append(result.str().c_str());
+}
+
+void wifi::showTrace(const QString& path)
+{
+    TraceReader reader(path);
+    if (!reader.isOpen()) {
+        ui.editResult->append("Unable to open trace: " + path);
+        return;
+    }
+
+    // Use the metrics window if set, otherwise about 100 points; never more than 10000 points
+    std::int64_t totalSlots = reader.getTotalSlots();
+    std::int64_t windowSlots = metricsWindow > 0 ? metricsWindow : totalSlots / 100;
+    windowSlots = std::max<std::int64_t>({ 1, windowSlots, totalSlots / 10000 });
+
+    TraceTotals totals = reader.totals(0, totalSlots);
+
+    std::ostringstream result;
+    result << "Trace: " << path.toStdString() << std::endl
+        << "Traced Slots: " << totals.slotCount << " Successful: " << totals.successful
+        << " Collisions: " << totals.collisions << " Idle: " << totals.idle << std::endl;
+
+    ui.editResult->append(result.str().c_str());
+
+    plotChart(reader.chartPoints(windowSlots), "Traced Simulation", "Window (" + QString::number(windowSlots) + " Units)", "Number of Collisions");
+}
+
+void wifi::showTraceError(const QString& path)
+{
+    ui.editResult->append("Unable to write trace file: " + path + " -- no trace is shown for this run");
 }
\ No newline at end of file
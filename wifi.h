@@ -4,6 +4,8 @@
 #include "simulation.h"
 #include "simulator.h"
 #include "backoff.h"
+#include "metrics.h"
+#include "edca.h"
 
 class wifi : public QMainWindow
 {
@@ -22,19 +24,30 @@ public slots:
     void updateProgress(int value);
     void finishedTask(double value);
     void createChart(const std::vector<Point>& data);
+    void showWindowMetrics(const MetricsSummary& summary);
+    void showEdcaStatistics(const EdcaTransmissions& totals);
+    void showTrace(const QString& path);
+    void showTraceError(const QString& path);
 
 private:
     int numberNodes;
     std::shared_ptr<BackoffStrategy> backoffStrategy;
     int minPacketSize;
     int maxPacketSize;
-    int simulationTime;
+    std::int64_t simulationTime;
     int numSimulations;
+    std::int64_t metricsWindow; // Slots per metrics window, 0 disables windowed metrics
+    bool metricsCsvEnabled;     // Stream every window to a CSV file
+    bool metricsCsvStreaming;   // The CSV file was created for the current run
+    bool traceEnabled;          // Record a slot trace of the first simulation
     QString selectedStrategy;
 
 
     Ui::wifiClass ui;
 
+    QString metricsCsvPath() const;
+    void plotChart(const std::vector<Point>& data, const QString& seriesName, const QString& xTitle, const QString& yTitle);
+
     QThread* simThread;
 
     std::unique_ptr<Simulation> sim;